@@ -0,0 +1,162 @@
+//============================================================================
+// Name : ActivationBench.cpp
+// Cost and accuracy of the sigmoid and tanh activations against cheaper
+// approximations, to choose which accuracy tiers are worth offering.
+//============================================================================
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+
+#include "Bench.hpp"
+
+
+namespace {
+
+const unsigned int kActivation_batch = 1024;
+// Inputs past this range are saturated for float tanh
+constexpr num_t kActivation_range = 8;
+
+
+// Pade approximant [7/6] of tanh, clamped where it leaves [-1, 1]
+inline num_t TanhRational(num_t x) {
+    const num_t x2 = x * x;
+    const num_t p = x * (135135.f + x2 * (17325.f + x2 * (378.f + x2)));
+    const num_t q = 135135.f + x2 * (62370.f + x2 * (3150.f + x2 * 28.f));
+    return std::max(num_t(-1), std::min(num_t(1), p / q));
+}
+
+
+// Table of tanh over [-kActivation_range, kActivation_range] with linear
+// interpolation between entries
+class TanhTable {
+ public:
+    static const unsigned int kSize = 512;
+
+    TanhTable() {
+        for (unsigned int n = 0; n <= kSize; n++) {
+            table_[n] = std::tanh(-kActivation_range + n / kScale);
+        }
+    }
+
+    inline num_t operator()(num_t x) const {
+        num_t pos = (x + kActivation_range) * kScale;
+        pos = std::max(num_t(0), std::min(num_t(kSize) - 1e-3f, pos));
+        const unsigned int n = static_cast<unsigned int>(pos);
+        const num_t frac = pos - n;
+        return table_[n] + frac * (table_[n + 1] - table_[n]);
+    }
+
+ private:
+    static constexpr num_t kScale = kSize / (2 * kActivation_range);
+    num_t table_[kSize + 1];
+};
+
+
+inline num_t SigmoidExact(num_t x) {
+    return 1 / (1 + std::exp(-x));
+}
+
+
+// sigmoid(x) = (1 + tanh(x / 2)) / 2
+template<typename TanhFunction>
+inline num_t SigmoidFromTanh(const TanhFunction &tanh_function, num_t x) {
+    return 0.5f + 0.5f * tanh_function(0.5f * x);
+}
+
+
+std::string FormatError(double error) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3g", error);
+    return buffer;
+}
+
+
+// Max and mean absolute error against the double precision function over
+// a dense grid on [-range, range]
+template<typename Approximation, typename Exact>
+microbench::Params ErrorParams(const Approximation &approximation,
+                               const Exact &exact,
+                               num_t range) {
+    static const unsigned int kGrid_points = 100001;
+    double max_error = 0, sum_error = 0;
+    for (unsigned int n = 0; n < kGrid_points; n++) {
+        const num_t x = -range + 2 * range * n / (kGrid_points - 1);
+        const double error = std::abs(approximation(x) - exact(double(x)));
+        max_error = std::max(max_error, error);
+        sum_error += error;
+    }
+    return { { "max_abs_error", FormatError(max_error) },
+             { "mean_abs_error", FormatError(sum_error / kGrid_points) } };
+}
+
+
+template<typename Function>
+void MeasureActivation(microbench::BenchContext *context,
+                       const std::string &activation,
+                       const std::string &tier,
+                       const microbench::Params &error_params,
+                       const d_vector &input,
+                       d_vector &output,
+                       const Function &function) {
+    microbench::Params params = { { "activation", activation },
+                                  { "tier", tier } };
+    params.insert(params.end(), error_params.begin(), error_params.end());
+
+    context->Measure("activation",
+                     params,
+                     input.size(), "elements",
+                     [&]() {
+                         for (size_t n = 0; n < input.size(); n++) {
+                             output[n] = function(input[n]);
+                         }
+                         microbench::DoNotOptimise(output.data());
+                     });
+}
+
+}  // namespace
+
+
+BENCH(ActivationApproximations) {
+    // Pre-activations spread over the whole range, saturated tails included
+    d_vector input(kActivation_batch), output(kActivation_batch);
+    for (unsigned int n = 0; n < kActivation_batch; n++) {
+        input[n] = -kActivation_range +
+                   2 * kActivation_range * n / (kActivation_batch - 1);
+    }
+    const TanhTable tanh_table;
+
+    const auto tanh_exact = [](num_t x) { return std::tanh(x); };
+    const auto tanh_reference = [](double x) { return std::tanh(x); };
+    const auto sigmoid_reference = [](double x) { return 1 / (1 + std::exp(-x)); };
+    const auto sigmoid_rational = [](num_t x) {
+        return SigmoidFromTanh(TanhRational, x);
+    };
+    const auto sigmoid_table = [&tanh_table](num_t x) {
+        return SigmoidFromTanh(tanh_table, x);
+    };
+
+    MeasureActivation(__microbench_context, "tanh", "exact",
+                      ErrorParams(tanh_exact, tanh_reference, kActivation_range),
+                      input, output, tanh_exact);
+    MeasureActivation(__microbench_context, "tanh", "rational",
+                      ErrorParams(TanhRational, tanh_reference, kActivation_range),
+                      input, output, TanhRational);
+    MeasureActivation(__microbench_context, "tanh", "lut",
+                      ErrorParams(tanh_table, tanh_reference, kActivation_range),
+                      input, output, tanh_table);
+
+    MeasureActivation(__microbench_context, "sigmoid", "exact",
+                      ErrorParams(SigmoidExact, sigmoid_reference,
+                                  2 * kActivation_range),
+                      input, output, SigmoidExact);
+    MeasureActivation(__microbench_context, "sigmoid", "rational",
+                      ErrorParams(sigmoid_rational, sigmoid_reference,
+                                  2 * kActivation_range),
+                      input, output, sigmoid_rational);
+    MeasureActivation(__microbench_context, "sigmoid", "lut",
+                      ErrorParams(sigmoid_table, sigmoid_reference,
+                                  2 * kActivation_range),
+                      input, output, sigmoid_table);
+}
@@ -0,0 +1,81 @@
+//============================================================================
+// Name : DatasetBench.cpp
+// Cost of recording examples into a capped Dataset.
+//============================================================================
+#include <vector>
+#include <string>
+
+#include "Bench.hpp"
+#include "Dataset.hpp"
+
+
+BENCH(DatasetAddFIFO) {
+    // Gesture recording: sensor frames added at rate into a full dataset,
+    // so that every Add forgets the oldest example
+    static const size_t kN_features = 16;
+    static const size_t kN_labels = 4;
+    const std::vector<size_t> capacities = { 100, 1000, 10000 };
+
+    for (const auto capacity : capacities) {
+        Dataset ds;
+        ds.ReplayMemory(true);
+        ds.SetForgetMode(Dataset::FIFO);
+        ds.SetMaxExamples(capacity);
+
+        std::vector<float> feature(kN_features, 0.5f);
+        std::vector<float> label(kN_labels, 0.f);
+        for (size_t n = 0; n < capacity; n++) {
+            ds.Add(feature, label);
+        }
+
+        float counter = 0;
+        MEASURE("Dataset::Add",
+                { { "forget_mode", "fifo" },
+                  { "capacity", std::to_string(capacity) },
+                  { "features", std::to_string(kN_features) } },
+                1, "examples",
+                [&]() {
+                    feature[0] = counter;
+                    counter += 1.f;
+                    ds.Add(feature, label);
+                });
+    }
+}
+
+
+BENCH(DatasetCopies) {
+    // Every training round starts by copying the dataset out, and the bias
+    // variants copy each row again to append 1.0
+    static const size_t kN_features = 16;
+    static const size_t kN_labels = 4;
+    const std::vector<size_t> sizes = { 100, 1000 };
+
+    for (const auto size : sizes) {
+        Dataset ds;
+        ds.SetMaxExamples(size);
+        std::vector<float> feature(kN_features, 0.5f);
+        std::vector<float> label(kN_labels, 0.f);
+        for (size_t n = 0; n < size; n++) {
+            ds.Add(feature, label);
+        }
+
+        for (const bool with_bias : { false, true }) {
+            const microbench::Params params = {
+                { "examples", std::to_string(size) },
+                { "bias", with_bias ? "true" : "false" } };
+
+            MEASURE("Dataset::GetFeatures", params,
+                    static_cast<double>(size), "examples",
+                    [&]() {
+                        auto features = ds.GetFeatures(with_bias);
+                        microbench::DoNotOptimise(features.data());
+                    });
+            MEASURE("Dataset::Sample", params,
+                    static_cast<double>(size), "examples",
+                    [&]() {
+                        auto sample = ds.Sample(with_bias);
+                        microbench::DoNotOptimise(sample.first.data());
+                    });
+        }
+    }
+}
@@ -0,0 +1,116 @@
+//============================================================================
+// Name : LossBench.cpp
+// Cost of the loss functions and their gradients over a mini-batch.
+//============================================================================
+#include <vector>
+#include <string>
+#include <random>
+#include <utility>
+
+#include "Bench.hpp"
+#include "Loss.h"
+
+
+BENCH(LossMiniBatch) {
+    // One mini-batch of N samples by K outputs, evaluated sample by sample
+    // as the training loop does, gradients written to an N x K buffer
+    static const unsigned int kBatch_size = 32;
+    const std::vector<size_t> output_sizes = { 2, 16, 128 };
+    const std::vector< std::pair<std::string, loss::loss_func_t<num_t> > > losses = {
+        { "mse", &loss::MSE<num_t> },
+        { "cce", &loss::CategoricalCrossEntropy<num_t> },
+    };
+
+    for (const auto output_size : output_sizes) {
+        std::mt19937 engine(output_size);
+        std::uniform_real_distribution<num_t> logit_dist(-5, 5);
+        std::uniform_int_distribution<size_t> class_dist(0, output_size - 1);
+        nd_vector expected(kBatch_size, d_vector(output_size, 0));
+        nd_vector actual(kBatch_size, d_vector(output_size));
+        nd_vector deriv_out(kBatch_size, d_vector(output_size));
+        for (unsigned int n = 0; n < kBatch_size; n++) {
+            expected[n][class_dist(engine)] = 1;  // one-hot
+            for (auto &y : actual[n]) {
+                y = logit_dist(engine);
+            }
+        }
+
+        for (const auto &loss_function : losses) {
+            MEASURE("loss",
+                    { { "loss", loss_function.first },
+                      { "outputs", std::to_string(output_size) },
+                      { "minibatch", std::to_string(kBatch_size) } },
+                    kBatch_size, "samples",
+                    [&]() {
+                        num_t batch_loss = 0;
+                        for (unsigned int n = 0; n < kBatch_size; n++) {
+                            batch_loss += loss_function.second(
+                                expected[n], actual[n], deriv_out[n],
+                                num_t(1) / kBatch_size);
+                        }
+                        microbench::DoNotOptimise(batch_loss);
+                        microbench::DoNotOptimise(deriv_out.data());
+                    });
+        }
+    }
+}
+
+
+BENCH(LossDispatch) {
+    // The same loss called through the pointer from LossFunctionsManager,
+    // as MLP<T> resolves it at run time, and as a direct template call the
+    // compiler can inline into the batch loop
+    static const unsigned int kBatch_size = 32;
+    static const size_t kOutputs = 16;
+
+    std::mt19937 engine(kOutputs);
+    std::uniform_real_distribution<num_t> dist(0, 1);
+    nd_vector expected(kBatch_size, d_vector(kOutputs));
+    nd_vector actual(kBatch_size, d_vector(kOutputs));
+    nd_vector deriv_out(kBatch_size, d_vector(kOutputs));
+    for (unsigned int n = 0; n < kBatch_size; n++) {
+        for (size_t k = 0; k < kOutputs; k++) {
+            expected[n][k] = dist(engine);
+            actual[n][k] = dist(engine);
+        }
+    }
+
+    auto loss_mgr = loss::LossFunctionsManager<num_t>::Singleton();
+    MLP_LOSS_FN loss::loss_func_t<num_t> loss_func;
+    if (!loss_mgr.GetLossFunction(loss::LOSS_FUNCTIONS::LOSS_MSE, &loss_func)) {
+        return;
+    }
+
+    MEASURE("loss",
+            { { "loss", "mse" },
+              { "outputs", std::to_string(kOutputs) },
+              { "minibatch", std::to_string(kBatch_size) },
+              { "dispatch", "runtime" } },
+            kBatch_size, "samples",
+            [&]() {
+                num_t batch_loss = 0;
+                for (unsigned int n = 0; n < kBatch_size; n++) {
+                    batch_loss += loss_func(expected[n], actual[n],
+                                            deriv_out[n],
+                                            num_t(1) / kBatch_size);
+                }
+                microbench::DoNotOptimise(batch_loss);
+                microbench::DoNotOptimise(deriv_out.data());
+            });
+    MEASURE("loss",
+            { { "loss", "mse" },
+              { "outputs", std::to_string(kOutputs) },
+              { "minibatch", std::to_string(kBatch_size) },
+              { "dispatch", "static" } },
+            kBatch_size, "samples",
+            [&]() {
+                num_t batch_loss = 0;
+                for (unsigned int n = 0; n < kBatch_size; n++) {
+                    batch_loss += loss::MSE<num_t>(expected[n], actual[n],
+                                                   deriv_out[n],
+                                                   num_t(1) / kBatch_size);
+                }
+                microbench::DoNotOptimise(batch_loss);
+                microbench::DoNotOptimise(deriv_out.data());
+            });
+}
@@ -0,0 +1,423 @@
+//============================================================================
+// Name : MLPBench.cpp
+// Inference and training throughput of MLP<T> over a sweep of topologies,
+// hidden layer activations and loss functions.
+//============================================================================
+#include <vector>
+#include <string>
+#include <random>
+#include <utility>
+#include <algorithm>
+#include <thread>
+
+#include "Bench.hpp"
+#include "MLP.h"
+
+
+namespace {
+
+// Layer sizes, input size including bias
+const std::vector< std::vector<size_t> > kTopologies = {
+    { 2, 4, 1 },
+    { 8, 16, 4 },
+    { 16, 64, 8 },
+    { 32, 128, 128, 8 },
+    { 64, 256, 256, 16 },
+};
+
+// Activation of the hidden layers, the output layer is always linear
+const std::vector< std::pair<std::string, ACTIVATION_FUNCTIONS> > kActivations = {
+    { "relu", ACTIVATION_FUNCTIONS::RELU },
+    { "sigmoid", ACTIVATION_FUNCTIONS::SIGMOID },
+    { "tanh", ACTIVATION_FUNCTIONS::TANH },
+    { "linear", ACTIVATION_FUNCTIONS::LINEAR },
+};
+
+const std::vector< std::pair<std::string, loss::LOSS_FUNCTIONS> > kLosses = {
+    { "mse", loss::LOSS_FUNCTIONS::LOSS_MSE },
+    { "cce", loss::LOSS_FUNCTIONS::LOSS_CATEGORICAL_CROSSENTROPY },
+};
+
+const unsigned int kTraining_samples = 32;
+const unsigned int kMinibatch_size = 8;
+// Small enough not to diverge in a long measurement
+const num_t kLearning_rate = 0.0001;
+
+
+size_t NumWeights(const std::vector<size_t> &topology) {
+    size_t n_weights = 0;
+    for (size_t l = 0; l + 1 < topology.size(); l++) {
+        n_weights += topology[l] * topology[l + 1];
+    }
+    return n_weights;
+}
+
+
+d_vector RandomInput(size_t size, std::mt19937 &engine) {
+    std::uniform_real_distribution<num_t> dist(-1, 1);
+    d_vector input(size);
+    for (auto &x : input) {
+        x = dist(engine);
+    }
+    input.back() = 1;  // bias
+    return input;
+}
+
+
+MLP<num_t>::training_pair_t RandomTrainingSet(
+        const std::vector<size_t> &topology,
+        loss::LOSS_FUNCTIONS loss_function,
+        unsigned int n_samples) {
+    std::mt19937 engine(n_samples);
+    std::uniform_real_distribution<num_t> dist(0, 1);
+    std::uniform_int_distribution<size_t> class_dist(0, topology.back() - 1);
+
+    MLP<num_t>::training_pair_t training_set;
+    for (unsigned int n = 0; n < n_samples; n++) {
+        training_set.first.push_back(RandomInput(topology.front(), engine));
+        d_vector label(topology.back(), 0);
+        if (loss_function == loss::LOSS_FUNCTIONS::LOSS_CATEGORICAL_CROSSENTROPY) {
+            label[class_dist(engine)] = 1;  // one-hot
+        } else {
+            for (auto &y : label) {
+                y = dist(engine);
+            }
+        }
+        training_set.second.push_back(label);
+    }
+    return training_set;
+}
+
+}  // namespace
+
+
+BENCH(MLPGetOutput) {
+    for (const auto &topology : kTopologies) {
+        for (const auto &activation : kActivations) {
+            MLP<num_t> mlp(topology,
+                           LayerActivations(topology, activation.second));
+            std::mt19937 engine(0);
+            const d_vector input = RandomInput(topology.front(), engine);
+            d_vector output;
+
+            MEASURE("MLP::GetOutput",
+                    { { "topology", TopologyName(topology) },
+                      { "activation", activation.first } },
+                    1, "inferences",
+                    [&]() {
+                        mlp.GetOutput(input, &output);
+                        microbench::DoNotOptimise(output.data());
+                    });
+        }
+    }
+}
+
+
+BENCH(MLPTrain) {
+    for (const auto &topology : kTopologies) {
+        for (const auto &activation : kActivations) {
+            for (const auto &loss_function : kLosses) {
+                MLP<num_t> mlp(topology,
+                               LayerActivations(topology, activation.second),
+                               loss_function.second);
+                const auto training_set = RandomTrainingSet(
+                    topology, loss_function.second, kTraining_samples);
+
+                // One epoch per call
+                MEASURE("MLP::Train",
+                        { { "topology", TopologyName(topology) },
+                          { "activation", activation.first },
+                          { "loss", loss_function.first } },
+                        kTraining_samples, "samples",
+                        [&]() {
+                            mlp.Train(training_set, kLearning_rate, 1, 0., false);
+                        });
+            }
+        }
+    }
+}
+
+
+BENCH(MLPMiniBatchTrain) {
+    for (const auto &topology : kTopologies) {
+        for (const auto &activation : kActivations) {
+            for (const auto &loss_function : kLosses) {
+                MLP<num_t> mlp(topology,
+                               LayerActivations(topology, activation.second),
+                               loss_function.second);
+                const auto training_set = RandomTrainingSet(
+                    topology, loss_function.second, kTraining_samples);
+
+                // One mini-batch iteration per call
+                MEASURE("MLP::MiniBatchTrain",
+                        { { "topology", TopologyName(topology) },
+                          { "activation", activation.first },
+                          { "loss", loss_function.first },
+                          { "minibatch", std::to_string(kMinibatch_size) } },
+                        kMinibatch_size, "samples",
+                        [&]() {
+                            mlp.MiniBatchTrain(training_set, kLearning_rate,
+                                               1, kMinibatch_size, 0.);
+                        });
+            }
+        }
+    }
+}
+
+
+BENCH(MLPWeightViews) {
+    for (const auto &topology : kTopologies) {
+        MLP<num_t> mlp(topology,
+                       LayerActivations(topology, ACTIVATION_FUNCTIONS::RELU));
+        const MLP<num_t>::mlp_weights weights = mlp.GetWeights();
+        const size_t n_weights = NumWeights(topology);
+
+        MEASURE("MLP::GetWeights",
+                { { "topology", TopologyName(topology) } },
+                static_cast<double>(n_weights), "weights",
+                [&]() {
+                    auto copy = mlp.GetWeights();
+                    microbench::DoNotOptimise(copy.data());
+                });
+        MEASURE("MLP::SetWeights",
+                { { "topology", TopologyName(topology) } },
+                static_cast<double>(n_weights), "weights",
+                [&]() {
+                    mlp.SetWeights(weights);
+                });
+        // Shadow copy for training next to a model serving inference
+        MEASURE("MLP::MLP(copy)",
+                { { "topology", TopologyName(topology) } },
+                static_cast<double>(n_weights), "weights",
+                [&]() {
+                    MLP<num_t> shadow(mlp);
+                    microbench::DoNotOptimise(shadow);
+                });
+    }
+}
+
+
+BENCH(MLPGridEvaluation) {
+    // Parameter-space visualisation: a 100x100 grid of 2D points plus bias,
+    // stored as one row-major matrix, outputs written to one caller buffer.
+    static const unsigned int kGrid_side = 100;
+    static const unsigned int kGrid_points = kGrid_side * kGrid_side;
+    const std::vector< std::vector<size_t> > topologies = {
+        { 3, 16, 16, 4 },
+        { 3, 64, 64, 16 },
+    };
+
+    for (const auto &topology : topologies) {
+        MLP<num_t> mlp(topology,
+                       LayerActivations(topology, ACTIVATION_FUNCTIONS::TANH));
+        const size_t in_size = topology.front();
+        const size_t out_size = topology.back();
+        d_vector grid(kGrid_points * in_size);
+        for (unsigned int n = 0; n < kGrid_points; n++) {
+            grid[n * in_size] = static_cast<num_t>(n % kGrid_side) / kGrid_side;
+            grid[n * in_size + 1] = static_cast<num_t>(n / kGrid_side) / kGrid_side;
+            grid[n * in_size + 2] = 1;  // bias
+        }
+        d_vector outputs(kGrid_points * out_size);
+
+        // Baseline for a batched entry point: one GetOutput per row
+        d_vector input(in_size), output;
+        MEASURE("MLP::GetOutput(grid)",
+                { { "topology", TopologyName(topology) },
+                  { "points", std::to_string(kGrid_points) } },
+                kGrid_points, "inferences",
+                [&]() {
+                    for (unsigned int n = 0; n < kGrid_points; n++) {
+                        input.assign(grid.begin() + n * in_size,
+                                     grid.begin() + (n + 1) * in_size);
+                        mlp.GetOutput(input, &output);
+                        std::copy(output.begin(), output.end(),
+                                  outputs.begin() + n * out_size);
+                    }
+                    microbench::DoNotOptimise(outputs.data());
+                });
+    }
+}
+
+
+BENCH(MLPMiniBatchTrainScaling) {
+    // Large mini-batches on large models, where splitting a batch across
+    // worker threads has something to gain
+    static const unsigned int kScaling_samples = 256;
+    const std::vector< std::vector<size_t> > topologies = {
+        { 32, 128, 128, 8 },
+        { 64, 256, 256, 16 },
+    };
+    const std::vector<unsigned int> minibatch_sizes = { 8, 32, 128 };
+
+    for (const auto &topology : topologies) {
+        const auto training_set = RandomTrainingSet(
+            topology, loss::LOSS_FUNCTIONS::LOSS_MSE, kScaling_samples);
+        for (const auto minibatch_size : minibatch_sizes) {
+            MLP<num_t> mlp(topology,
+                           LayerActivations(topology, ACTIVATION_FUNCTIONS::RELU));
+
+            MEASURE("MLP::MiniBatchTrain",
+                    { { "topology", TopologyName(topology) },
+                      { "activation", "relu" },
+                      { "loss", "mse" },
+                      { "minibatch", std::to_string(minibatch_size) } },
+                    minibatch_size, "samples",
+                    [&]() {
+                        mlp.MiniBatchTrain(training_set, kLearning_rate,
+                                           1, minibatch_size, 0.);
+                    });
+        }
+    }
+}
+
+
+BENCH(MLPDeployedTopologies) {
+    // Topologies fixed at build time in deployed models, the candidates for
+    // a statically sized network
+    const std::vector< std::pair< std::vector<size_t>,
+                                  std::vector<ACTIVATION_FUNCTIONS> > > models = {
+        // TestIrisDataset: 4 inputs + bias, 4 hidden, 3 classes
+        { { 4 + 1, 4, 3 },
+          { ACTIVATION_FUNCTIONS::SIGMOID, ACTIVATION_FUNCTIONS::LINEAR } },
+        // FuncLearnRunner::MakeModel
+        { { 1, 4, 4, 1 },
+          { ACTIVATION_FUNCTIONS::RELU, ACTIVATION_FUNCTIONS::RELU,
+            ACTIVATION_FUNCTIONS::TANH } },
+    };
+
+    for (const auto &model : models) {
+        MLP<num_t> mlp(model.first, model.second);
+        std::mt19937 engine(0);
+        const d_vector input = RandomInput(model.first.front(), engine);
+        d_vector output;
+
+        MEASURE("MLP::GetOutput",
+                { { "topology", TopologyName(model.first) },
+                  { "activation", "deployed" } },
+                1, "inferences",
+                [&]() {
+                    mlp.GetOutput(input, &output);
+                    microbench::DoNotOptimise(output.data());
+                });
+    }
+}
+
+
+BENCH(MLPTrainToConvergence) {
+    // Wall time from a fresh model to a fitted mapping, with the settings of
+    // MLPLearnXORCategoricalCrossEntropy. Plain SGD needs a large learning
+    // rate and thousands of epochs here; an optimizer that converges in
+    // fewer epochs shows up as a shorter time per call.
+    const std::vector<size_t> topology = { 3, 4, 2 };
+    const MLP<num_t>::training_pair_t xor_set = {
+        { { 0, 0, 1 }, { 0, 1, 1 }, { 1, 0, 1 }, { 1, 1, 1 } },
+        { { 1, 0 }, { 0, 1 }, { 0, 1 }, { 1, 0 } },
+    };
+
+    MEASURE("MLP::Train(converge)",
+            { { "topology", TopologyName(topology) },
+              { "activation", "sigmoid" },
+              { "loss", "cce" },
+              { "task", "xor" } },
+            1, "fits",
+            [&]() {
+                MLP<num_t> mlp(topology,
+                               LayerActivations(topology,
+                                                ACTIVATION_FUNCTIONS::SIGMOID),
+                               loss::LOSS_FUNCTIONS::LOSS_CATEGORICAL_CROSSENTROPY);
+                mlp.Train(xor_set, 3.0, 10000, 0.001, false);
+                microbench::DoNotOptimise(mlp);
+            });
+}
+
+
+BENCH(MLPConcurrentGetOutput) {
+    // Voice and controller threads sharing one mapping, each with its own
+    // copy of the model as GetOutput requires today; throughput summed
+    // over the threads and the weights held once per thread
+    static const unsigned int kInferences_per_thread = 1000;
+    const std::vector<size_t> topology = { 16, 64, 8 };
+    const std::vector<unsigned int> thread_counts = { 1, 2, 4 };
+
+    MLP<num_t> mlp(topology,
+                   LayerActivations(topology, ACTIVATION_FUNCTIONS::TANH));
+    std::mt19937 engine(0);
+    const d_vector input = RandomInput(topology.front(), engine);
+
+    for (const auto n_threads : thread_counts) {
+        std::vector< MLP<num_t> > copies(n_threads, mlp);
+        std::vector<d_vector> outputs(n_threads);
+
+        MEASURE("MLP::GetOutput(threads)",
+                { { "topology", TopologyName(topology) },
+                  { "activation", "tanh" },
+                  { "threads", std::to_string(n_threads) } },
+                n_threads * kInferences_per_thread, "inferences",
+                [&]() {
+                    std::vector<std::thread> threads;
+                    for (unsigned int t = 0; t < n_threads; t++) {
+                        threads.emplace_back([&, t]() {
+                            for (unsigned int n = 0; n < kInferences_per_thread; n++) {
+                                copies[t].GetOutput(input, &outputs[t]);
+                            }
+                            microbench::DoNotOptimise(outputs[t].data());
+                        });
+                    }
+                    for (auto &thread : threads) {
+                        thread.join();
+                    }
+                });
+    }
+}
+
+
+BENCH(MLPExploration) {
+    // Auditioning sounds: perturbed copies of a base model, each evaluated
+    // on a shared set of probe inputs, one candidate after the other
+    static const unsigned int kCandidates = 16;
+    static const unsigned int kProbes = 32;
+    static const num_t kStep = 0.1;
+
+    for (const auto &topology : kTopologies) {
+        MLP<num_t> mlp(topology,
+                       LayerActivations(topology, ACTIVATION_FUNCTIONS::TANH));
+        const size_t n_weights = NumWeights(topology);
+
+        MEASURE("MLP::DrawWeights",
+                { { "topology", TopologyName(topology) } },
+                static_cast<double>(n_weights), "weights",
+                [&]() {
+                    mlp.DrawWeights();
+                });
+        MEASURE("MLP::MoveWeights",
+                { { "topology", TopologyName(topology) } },
+                static_cast<double>(n_weights), "weights",
+                [&]() {
+                    mlp.MoveWeights(kStep);
+                });
+
+        std::mt19937 engine(kProbes);
+        nd_vector probes;
+        for (unsigned int n = 0; n < kProbes; n++) {
+            probes.push_back(RandomInput(topology.front(), engine));
+        }
+        nd_vector outputs(kCandidates * kProbes);
+        MEASURE("MLP::MoveWeights(audition)",
+                { { "topology", TopologyName(topology) },
+                  { "candidates", std::to_string(kCandidates) },
+                  { "probes", std::to_string(kProbes) } },
+                kCandidates, "candidates",
+                [&]() {
+                    for (unsigned int c = 0; c < kCandidates; c++) {
+                        MLP<num_t> candidate(mlp);
+                        candidate.MoveWeights(kStep);
+                        for (unsigned int n = 0; n < kProbes; n++) {
+                            candidate.GetOutput(probes[n],
+                                                &outputs[c * kProbes + n]);
+                        }
+                    }
+                    microbench::DoNotOptimise(outputs.data());
+                });
+    }
+}
@@ -0,0 +1,48 @@
+//============================================================================
+// Name : RandomBench.cpp
+// Throughput of the random generators behind weight initialisation and
+// exploration.
+//============================================================================
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "Bench.hpp"
+#include "Utils.h"
+
+
+BENCH(RandomGenerators) {
+    // Bulk fills of a weight-sized buffer, as DrawWeights and MoveWeights
+    // do for a whole model
+    const std::vector<size_t> fill_sizes = { 64, 4096, 65536 };
+
+    for (const auto fill_size : fill_sizes) {
+        d_vector values(fill_size);
+        utils::gen_rand<num_t> gen_rand;
+        utils::gen_randn<num_t> gen_randn(0.1);
+
+        MEASURE("utils::gen_rand",
+                { { "values", std::to_string(fill_size) } },
+                fill_size, "values",
+                [&]() {
+                    std::generate_n(values.begin(), fill_size, gen_rand);
+                    microbench::DoNotOptimise(values.data());
+                });
+        MEASURE("utils::gen_randn",
+                { { "values", std::to_string(fill_size) } },
+                fill_size, "values",
+                [&]() {
+                    std::generate_n(values.begin(), fill_size, gen_randn);
+                    microbench::DoNotOptimise(values.data());
+                });
+        // Perturbation of existing values, as in MoveWeights
+        MEASURE("utils::gen_randn(x)",
+                { { "values", std::to_string(fill_size) } },
+                fill_size, "values",
+                [&]() {
+                    std::transform(values.begin(), values.end(),
+                                   values.begin(), gen_randn);
+                    microbench::DoNotOptimise(values.data());
+                });
+    }
+}
@@ -0,0 +1,144 @@
+//============================================================================
+// Name : SerialiseBench.cpp
+// Cost of saving and restoring model weights through the binary format of
+// utils/Serialise.hpp.
+//============================================================================
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+
+#include "Bench.hpp"
+#include "MLP.h"
+#include "utils/Serialise.hpp"
+
+
+namespace {
+
+// From a small controller mapping to a ~1M weight model
+const std::vector< std::vector<size_t> > kSerialise_topologies = {
+    { 16, 64, 8 },
+    { 64, 256, 256, 16 },
+    { 1000, 1000, 1 },
+};
+
+}  // namespace
+
+
+BENCH(MLPSerialise) {
+    for (const auto &topology : kSerialise_topologies) {
+        MLP<num_t> mlp(topology,
+                       LayerActivations(topology, ACTIVATION_FUNCTIONS::RELU));
+        std::vector<uint8_t> reused;
+        const size_t n_bytes = mlp.Serialise(0, reused);
+
+        // As in MLPSerialise: a new buffer grown while writing, so the
+        // whole model is held twice and reallocated on the way
+        MEASURE("MLP::Serialise",
+                { { "topology", TopologyName(topology) },
+                  { "buffer", "new" } },
+                static_cast<double>(n_bytes), "bytes",
+                [&]() {
+                    std::vector<uint8_t> serialised;
+                    mlp.Serialise(0, serialised);
+                    microbench::DoNotOptimise(serialised.data());
+                });
+        // Into the capacity left by the previous call, as a bounded sink would
+        MEASURE("MLP::Serialise",
+                { { "topology", TopologyName(topology) },
+                  { "buffer", "reused" } },
+                static_cast<double>(n_bytes), "bytes",
+                [&]() {
+                    reused.clear();
+                    mlp.Serialise(0, reused);
+                    microbench::DoNotOptimise(reused.data());
+                });
+    }
+}
+
+
+BENCH(SerialiseVector2D) {
+    // One 1000x1000 weight matrix, the ~1M weight model of MLPSerialise,
+    // through the 2D vector primitives, and the model-level restore
+    static const size_t kRows = 1000;
+    static const size_t kCols = 1000;
+    const std::vector< std::vector<num_t> > matrix(
+        kRows, std::vector<num_t>(kCols, 0.5f));
+    std::vector<uint8_t> buffer;
+    const size_t n_bytes = Serialise::FromVector2D(0, matrix, buffer);
+
+    MEASURE("Serialise::FromVector2D",
+            { { "rows", std::to_string(kRows) },
+              { "cols", std::to_string(kCols) } },
+            static_cast<double>(n_bytes), "bytes",
+            [&]() {
+                buffer.clear();
+                Serialise::FromVector2D(0, matrix, buffer);
+                microbench::DoNotOptimise(buffer.data());
+            });
+
+    std::vector< std::vector<num_t> > restored;
+    MEASURE("Serialise::ToVector2D",
+            { { "rows", std::to_string(kRows) },
+              { "cols", std::to_string(kCols) } },
+            static_cast<double>(n_bytes), "bytes",
+            [&]() {
+                Serialise::ToVector2D<num_t>(0, buffer, restored);
+                microbench::DoNotOptimise(restored.data());
+            });
+
+    const std::vector<size_t> topology = { kCols, kRows, 1 };
+    MLP<num_t> mlp(topology,
+                   LayerActivations(topology, ACTIVATION_FUNCTIONS::RELU));
+    std::vector<uint8_t> serialised;
+    const size_t n_model_bytes = mlp.Serialise(0, serialised);
+    MEASURE("MLP::FromSerialised",
+            { { "topology", TopologyName(topology) } },
+            static_cast<double>(n_model_bytes), "bytes",
+            [&]() {
+                mlp.FromSerialised(0, serialised);
+            });
+}
+
+
+BENCH(MLPModelFiles) {
+    // Switching a set of models: each one saved to its own file, then the
+    // whole set loaded back with MLP(path) as in TestIrisDataset
+    static const unsigned int kModels_in_set = 24;
+
+    for (const auto &topology : kSerialise_topologies) {
+        std::vector<std::string> paths;
+        for (unsigned int n = 0; n < kModels_in_set; n++) {
+            paths.push_back("memlp_bench_" + TopologyName(topology) + "_" +
+                            std::to_string(n) + ".mlp");
+        }
+        MLP<num_t> mlp(topology,
+                       LayerActivations(topology, ACTIVATION_FUNCTIONS::RELU));
+        std::vector<uint8_t> serialised;
+        const size_t n_bytes = mlp.Serialise(0, serialised) * kModels_in_set;
+
+        MEASURE("MLP::SaveMLPNetwork",
+                { { "topology", TopologyName(topology) },
+                  { "models", std::to_string(kModels_in_set) } },
+                static_cast<double>(n_bytes), "bytes",
+                [&]() {
+                    for (const auto &path : paths) {
+                        mlp.SaveMLPNetwork(path);
+                    }
+                });
+        MEASURE("MLP::MLP(path)",
+                { { "topology", TopologyName(topology) },
+                  { "models", std::to_string(kModels_in_set) } },
+                static_cast<double>(n_bytes), "bytes",
+                [&]() {
+                    for (const auto &path : paths) {
+                        MLP<num_t> loaded(path);
+                        microbench::DoNotOptimise(loaded);
+                    }
+                });
+
+        for (const auto &path : paths) {
+            std::remove(path.c_str());
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/**
+* @file AllocCounter.hpp
+* @brief Replacement of the global operator new/delete which counts every
+*        heap allocation made by the process.
+*
+* Like UnitTest.hpp, this header defines (rather than declares) its symbols:
+* include it from exactly one translation unit per executable, i.e. the one
+* that holds main(). Allocation counts are read with alloc_counter::Count()
+* before and after the code under measurement.
+*
+* @code{.cpp}
+*  size_t before = alloc_counter::Count();
+*  mlp.GetOutput(input, &output);
+*  size_t allocations = alloc_counter::Count() - before;
+* @endcode
+*/
+
+#ifndef __ALLOC_COUNTER_HPP__
+#define __ALLOC_COUNTER_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace alloc_counter {
+  /**
+  * @brief Number of calls to any operator new since process start.
+  */
+  std::atomic<size_t> g_allocations{ 0 };
+
+  /**
+  * @brief Read the current allocation count.
+  * @returns Number of heap allocations made so far.
+  */
+  inline size_t Count() {
+    return g_allocations.load(std::memory_order_relaxed);
+  }
+
+  /**
+  * @brief Helper to allocate a block of memory, reporting failure the way
+  *        the standard operator new does.
+  */
+  inline void* Allocate(std::size_t size, std::size_t alignment) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) {
+      size = 1;
+    }
+    void *ptr = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+      ptr = std::malloc(size);
+    }
+    else {
+      // aligned_alloc() wants the size to be a multiple of the alignment
+      size = (size + alignment - 1) & ~(alignment - 1);
+      ptr = std::aligned_alloc(alignment, size);
+    }
+    if (!ptr) {
+#if defined(__cpp_exceptions)
+      throw std::bad_alloc();
+#else
+      std::abort();
+#endif
+    }
+    return ptr;
+  }
+}
+
+void* operator new(std::size_t size) {
+  return alloc_counter::Allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size) {
+  return alloc_counter::Allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return alloc_counter::Allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return alloc_counter::Allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+
+#endif  // __ALLOC_COUNTER_HPP__
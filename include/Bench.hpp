@@ -0,0 +1,43 @@
+#ifndef __BENCH_HPP__
+#define __BENCH_HPP__
+
+
+#include <vector>
+#include <string>
+#include "microbench.h"
+#include "easylogging++.h"
+#include "Utils.h"
+
+INITIALIZE_EASYLOGGINGPP
+
+
+using num_t = float;
+using d_vector = std::vector<num_t>;
+using nd_vector = std::vector< std::vector<num_t> >;
+
+
+/**
+ * Layer sizes as a benchmark parameter, e.g. "16-64-8".
+ */
+inline std::string TopologyName(const std::vector<size_t> &topology) {
+    std::string name;
+    for (size_t n = 0; n < topology.size(); n++) {
+        name += (n ? "-" : "") + std::to_string(topology[n]);
+    }
+    return name;
+}
+
+
+/**
+ * One activation per layer: hidden_activation, then a linear output layer.
+ */
+inline std::vector<ACTIVATION_FUNCTIONS> LayerActivations(
+        const std::vector<size_t> &topology,
+        ACTIVATION_FUNCTIONS hidden_activation) {
+    std::vector<ACTIVATION_FUNCTIONS> activations(topology.size() - 1,
+                                                  hidden_activation);
+    activations.back() = ACTIVATION_FUNCTIONS::LINEAR;
+    return activations;
+}
+
+#endif  // __BENCH_HPP__
@@ -68,6 +68,7 @@ public:
     void FUNCLEARNTEST_C_FN MakeData(const unsigned int n_examples);
     void MakeModel(void);
     void TrainModel(const unsigned int n_epochs);
+    number_t ValidateModel(const unsigned int weight_bits = 0);
 
 protected:
 
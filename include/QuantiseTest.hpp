@@ -0,0 +1,47 @@
+#ifndef __QUANTISE_TEST_HPP__
+#define __QUANTISE_TEST_HPP__
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "MLP.h"
+
+
+/**
+ * Simulate fixed-point weights: every layer gets one symmetric scale,
+ * max(|w|) / (2^(bits-1) - 1), and each weight is rounded to the nearest
+ * step. Returns the dequantised weights, ready for MLP<T>::SetWeights(),
+ * so that the accuracy cost of int8/int16 storage can be measured against
+ * the float model.
+ */
+template<typename T>
+typename MLP<T>::mlp_weights QuantiseWeights(
+    const typename MLP<T>::mlp_weights &weights,
+    unsigned int bits)
+{
+    const T q_max = static_cast<T>((1 << (bits - 1)) - 1);
+    typename MLP<T>::mlp_weights quantised(weights);
+
+    for (auto &layer : quantised) {
+        T w_max = 0;
+        for (const auto &node : layer) {
+            for (const auto &w : node) {
+                w_max = std::max(w_max, static_cast<T>(std::abs(w)));
+            }
+        }
+        if (w_max == 0) {
+            continue;
+        }
+        const T scale = w_max / q_max;
+        for (auto &node : layer) {
+            for (auto &w : node) {
+                w = std::round(w / scale) * scale;
+            }
+        }
+    }
+
+    return quantised;
+}
+
+#endif  // __QUANTISE_TEST_HPP__
@@ -5,6 +5,10 @@
 #include <vector>
 #include "microunit.h"
 #include "easylogging++.h"
+#if defined(LINUX)
+// The Pico SDK provides its own operator new/delete
+#include "AllocCounter.hpp"
+#endif
 
 INITIALIZE_EASYLOGGINGPP
 
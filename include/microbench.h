@@ -0,0 +1,385 @@
+/**
+* @file microbench.h
+* @brief Tiny benchmarking harness, the timing counterpart of microunit.h.
+*
+* Benchmarks are registered with the macro BENCH and run by
+* microbench::BenchRunner::Run() from main(). Inside a benchmark body, the
+* macro MEASURE times a callable: the callable is repeated until it has run
+* for at least the minimum measurement time, and wall time, throughput and
+* heap allocations per call are recorded. Once every benchmark has run, all
+* results are written out as JSON (default) or CSV so that they can be
+* compared release to release.
+*
+* @code{.cpp}
+*  BENCH(VectorPushBack) {
+*    std::vector<int> v;
+*    MEASURE("vector::push_back", {{"type", "int"}}, 1, "items", [&]() {
+*      v.push_back(1);
+*    });
+*  };
+*  // ...
+*  int main(int argc, char *argv[]){
+*    return microbench::BenchRunner::Run(argc, argv) ? 0 : -1;
+*  }
+* @endcode
+*
+* Command line options understood by BenchRunner::Run():
+* @li --format=json|csv : Report format (default json).
+* @li --out=PATH : Write the report to PATH instead of stdout.
+* @li --filter=TEXT : Only run benchmarks whose name contains TEXT.
+* @li --min-time=SECONDS : Minimum measurement time per result (default 0.1).
+*
+* This header pulls in AllocCounter.hpp and thus must only be included from
+* the translation unit holding main().
+*/
+
+#ifndef _MICROBENCH_MICROBENCH_H_
+#define _MICROBENCH_MICROBENCH_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AllocCounter.hpp"
+
+namespace microbench {
+  /**
+  * @brief Ordered list of key/value parameters describing one measurement,
+  *        e.g. {{"topology", "2-4-1"}, {"activation", "relu"}}.
+  */
+  typedef std::vector< std::pair<std::string, std::string> > Params;
+
+  /**
+  * @brief Result of one measurement.
+  */
+  struct Result {
+    std::string name;
+    Params params;
+    size_t iterations{ 0 };
+    double ns_per_op{ 0 };
+    double items_per_sec{ 0 };
+    std::string items_unit;
+    double allocs_per_op{ 0 };
+  };
+
+  /**
+  * @brief Runtime options of the benchmark runner.
+  */
+  struct Options {
+    std::string format{ "json" };
+    std::string out_path;
+    std::string filter;
+    double min_time_s{ 0.1 };
+  };
+
+  /**
+  * @brief Prevent the compiler from optimising away a value computed in a
+  *        measured loop.
+  */
+  template<typename T>
+  inline void DoNotOptimise(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+  }
+
+  /**
+  * @brief Context handed to every benchmark body. Runs the measurements
+  *        and collects their results.
+  */
+  class BenchContext {
+  public:
+    BenchContext(const Options &options, std::vector<Result> *results) :
+      options_(options), results_(results) {}
+
+    /**
+    * @brief Time a callable.
+    * @param [in] name  Name of the operation being measured.
+    * @param [in] params  Parameters of this measurement.
+    * @param [in] items_per_call  Work items (inferences, samples, bytes...)
+    *             processed by one call of fn, used to compute throughput.
+    * @param [in] items_unit  Name of the work item unit.
+    * @param [in] fn  Callable to measure.
+    */
+    template<typename Fn>
+    void Measure(const std::string &name, const Params &params,
+      double items_per_call, const std::string &items_unit, Fn &&fn) {
+      typedef std::chrono::steady_clock clock;
+      static const size_t kMax_iterations = 1u << 30;
+      const double min_time_ns = options_.min_time_s * 1e9;
+
+      // Warm-up call, so that lazy initialisation is not measured
+      fn();
+
+      size_t iterations = 1;
+      double elapsed_ns = 0;
+      size_t allocations = 0;
+      while (true) {
+        size_t allocations_before = alloc_counter::Count();
+        auto start = clock::now();
+        for (size_t n = 0; n < iterations; n++) {
+          fn();
+        }
+        elapsed_ns = std::chrono::duration<double, std::nano>(
+          clock::now() - start).count();
+        allocations = alloc_counter::Count() - allocations_before;
+        if (elapsed_ns >= min_time_ns || iterations >= kMax_iterations) {
+          break;
+        }
+        // Aim slightly past the target, growing at most 10x per round
+        double scale = (elapsed_ns > 0) ?
+          1.4 * min_time_ns / elapsed_ns : 10.;
+        scale = std::min(std::max(scale, 1.5), 10.);
+        iterations = std::max(iterations + 1,
+          static_cast<size_t>(static_cast<double>(iterations) * scale));
+      }
+
+      Result result;
+      result.name = name;
+      result.params = params;
+      result.iterations = iterations;
+      result.ns_per_op = elapsed_ns / static_cast<double>(iterations);
+      result.items_per_sec = (elapsed_ns > 0) ?
+        items_per_call * static_cast<double>(iterations) * 1e9 / elapsed_ns :
+        0.;
+      result.items_unit = items_unit;
+      result.allocs_per_op = static_cast<double>(allocations) /
+        static_cast<double>(iterations);
+      results_->push_back(result);
+
+      std::cerr << "  " << name;
+      for (const auto &param : params) {
+        std::cerr << " " << param.first << "=" << param.second;
+      }
+      std::cerr << ": " << result.ns_per_op << " ns/op, "
+        << result.items_per_sec << " " << items_unit << "/s, "
+        << result.allocs_per_op << " allocs/op" << std::endl;
+    }
+
+    const Options &options() const { return options_; }
+
+  private:
+    const Options &options_;
+    std::vector<Result> *results_;
+  };
+
+  /**
+  * @brief Benchmark function type.
+  */
+  typedef void(*BenchFunction)(BenchContext*);
+
+  /**
+  * @brief Helper to escape a string for a JSON report.
+  */
+  inline std::string JSONEscape(const std::string &in) {
+    std::string out;
+    out.reserve(in.size());
+    for (char c : in) {
+      if (c == '"' || c == '\\') {
+        out.push_back('\\');
+      }
+      out.push_back(c);
+    }
+    return out;
+  }
+
+  /**
+  * @brief Write results as a JSON document.
+  */
+  inline void WriteJSON(std::ostream &os, const Options &options,
+    const std::vector<Result> &results) {
+    os << "{\n  \"context\": {\n";
+#if defined(__VERSION__)
+    os << "    \"compiler\": \"" << JSONEscape(__VERSION__) << "\",\n";
+#endif
+    os << "    \"min_time_s\": " << options.min_time_s << "\n  },\n";
+    os << "  \"benchmarks\": [";
+    for (size_t n = 0; n < results.size(); n++) {
+      const Result &r = results[n];
+      os << (n ? ",\n" : "\n") << "    {\"name\": \""
+        << JSONEscape(r.name) << "\"";
+      for (const auto &param : r.params) {
+        os << ", \"" << JSONEscape(param.first) << "\": \""
+          << JSONEscape(param.second) << "\"";
+      }
+      os << ", \"iterations\": " << r.iterations
+        << ", \"ns_per_op\": " << r.ns_per_op
+        << ", \"items_per_sec\": " << r.items_per_sec
+        << ", \"items_unit\": \"" << JSONEscape(r.items_unit) << "\""
+        << ", \"allocs_per_op\": " << r.allocs_per_op << "}";
+    }
+    os << "\n  ]\n}\n";
+  }
+
+  /**
+  * @brief Write results as CSV, one row per result. Parameters are packed
+  *        into a single "key=value;key=value" column.
+  */
+  inline void WriteCSV(std::ostream &os, const std::vector<Result> &results) {
+    os << "name,params,iterations,ns_per_op,items_per_sec,items_unit,"
+      "allocs_per_op\n";
+    for (const Result &r : results) {
+      os << r.name << ",";
+      for (size_t n = 0; n < r.params.size(); n++) {
+        os << (n ? ";" : "") << r.params[n].first << "="
+          << r.params[n].second;
+      }
+      os << "," << r.iterations << "," << r.ns_per_op << ","
+        << r.items_per_sec << "," << r.items_unit << ","
+        << r.allocs_per_op << "\n";
+    }
+  }
+
+  /**
+  * @brief Main class for benchmark management. This class is a singleton
+  *        and maintains a list of all registered benchmarks.
+  */
+  class BenchRunner {
+  public:
+    /**
+    * @brief Run all the registered benchmarks matching the command line
+    *        filter, then write the report.
+    * @returns True if the report could be written, false otherwise.
+    */
+    static bool Run(int argc, char *argv[]) {
+      Options options;
+      if (!ParseOptions(argc, argv, &options)) {
+        return false;
+      }
+
+      std::vector<Result> results;
+      BenchContext context(options, &results);
+      for (auto &bench : Instance().benchfunction_map_) {
+        if (!options.filter.empty() &&
+          bench.first.find(options.filter) == std::string::npos) {
+          continue;
+        }
+        std::cerr << "Benchmark '" << bench.first << "'" << std::endl;
+        bench.second(&context);
+      }
+
+      std::ofstream out_file;
+      if (!options.out_path.empty()) {
+        out_file.open(options.out_path);
+        if (!out_file) {
+          std::cerr << "Could not open " << options.out_path << std::endl;
+          return false;
+        }
+      }
+      std::ostream &os = options.out_path.empty() ? std::cout : out_file;
+      if (options.format == "csv") {
+        WriteCSV(os, results);
+      }
+      else {
+        WriteJSON(os, options, results);
+      }
+      return static_cast<bool>(os);
+    }
+
+    /**
+    * @brief Register a benchmark function. In regular usage, this doesn't
+    *        need to be called, and the macro BENCH should be used instead.
+    * @param [in] name  Name of the benchmark.
+    * @param [in] function  Pointer to benchmark function.
+    */
+    static void RegisterFunction(const std::string &name,
+      BenchFunction function) {
+      Instance().benchfunction_map_.emplace(name, function);
+    }
+
+    /**
+    * @brief Helper class to register a benchmark in construction time.
+    *        Used by the REGISTER_BENCH macro, which in turn is used by the
+    *        BENCH macro.
+    */
+    class Registrator {
+    public:
+      Registrator(const std::string &name,
+        BenchFunction function) {
+        BenchRunner::RegisterFunction(name, function);
+      };
+      Registrator(const Registrator&) = delete;
+      Registrator(Registrator&&) = delete;
+      ~Registrator() {};
+    };
+
+    ~BenchRunner() {};
+    BenchRunner(const BenchRunner&) = delete;
+    BenchRunner(BenchRunner&&) = delete;
+
+  private:
+    BenchRunner() {};
+    static BenchRunner& Instance() {
+      static BenchRunner instance;
+      return instance;
+    }
+
+    static bool ParseOptions(int argc, char *argv[], Options *options) {
+      for (int n = 1; n < argc; n++) {
+        const std::string arg(argv[n]);
+        const size_t eq = arg.find('=');
+        const std::string key = arg.substr(0, eq);
+        const std::string value = (eq == std::string::npos) ?
+          "" : arg.substr(eq + 1);
+        if (key == "--format" && (value == "json" || value == "csv")) {
+          options->format = value;
+        }
+        else if (key == "--out") {
+          options->out_path = value;
+        }
+        else if (key == "--filter") {
+          options->filter = value;
+        }
+        else if (key == "--min-time" && std::atof(value.c_str()) > 0) {
+          options->min_time_s = std::atof(value.c_str());
+        }
+        else {
+          std::cerr << "Usage: " << argv[0]
+            << " [--format=json|csv] [--out=PATH] [--filter=TEXT]"
+            " [--min-time=SECONDS]" << std::endl;
+          return false;
+        }
+      }
+      return true;
+    }
+
+    std::map<std::string, BenchFunction> benchfunction_map_;
+  };
+}
+
+#define MICROBENCH_MACROCAT_NEXP(A, B) A ## B
+#define MICROBENCH_MACROCAT(A, B) MICROBENCH_MACROCAT_NEXP(A, B)
+
+/**
+* @brief Register a benchmark function using a helper static Registrator
+*        object.
+*/
+#define REGISTER_BENCH(FUNCTION)                                               \
+  static microbench::BenchRunner::Registrator                                  \
+  MICROBENCH_MACROCAT(MICROBENCH_REGISTRATION, __COUNTER__)(#FUNCTION, FUNCTION);
+
+/**
+* @brief Define a benchmark function body.
+*/
+#define BENCH(FUNCTION)                                                        \
+void FUNCTION(microbench::BenchContext*);                                      \
+REGISTER_BENCH(FUNCTION);                                                      \
+void FUNCTION(microbench::BenchContext *__microbench_context)
+
+/**
+* @brief Time a callable from inside a BENCH body.
+*        See microbench::BenchContext::Measure() for the arguments.
+*/
+#define MEASURE(...) __microbench_context->Measure(__VA_ARGS__)
+
+#endif  // _MICROBENCH_MICROBENCH_H_
@@ -14,6 +14,13 @@
 * @li FAIL() : Fail the test and return.
 * @li ASSERT_TRUE(condition) : If the condition does not hold, fail and return.
 * @li ASSERT_FALSE(condition) : If the condition holds, fail and return.
+* @li TIME_BUDGET_MS(ms) : Fail the test if it runs for longer than ms
+*     milliseconds. The test runs to completion either way.
+*
+* Run() times every test case. Pass it a report path ending in .json or
+* .csv to also write per-test results (pass/fail, wall time, time budget
+* and, if an allocation counter was set with SetAllocationCounter(), the
+* number of heap allocations) to that file.
 *
 * @code{.cpp}
 *  UNIT(Test_Two_Plus_Two) {
@@ -60,6 +67,8 @@
 #ifndef _MICROUNIT_MICROUNIT_H_
 #define _MICROUNIT_MICROUNIT_H_
 #include <string.h>
+#include <chrono>
+#include <fstream>
 #include <map>
 #include <string>
 #include <vector>
@@ -206,8 +215,26 @@ namespace microunit {
   */
   struct UnitFunctionResult {
     bool success{ true };
+    double time_budget_ms{ 0 };
   };
 
+  /**
+  * @brief Record of a completed unit test case, as written to the report.
+  */
+  struct UnitReport {
+    std::string name;
+    bool success{ true };
+    double time_ms{ 0 };
+    double time_budget_ms{ 0 };
+    long allocations{ -1 };
+  };
+
+  /**
+  * @brief Allocation counter type, returning the number of heap allocations
+  *        made so far.
+  */
+  typedef size_t(*AllocationCounter)();
+
   /**
   * @brief Unit test function type.
   */
@@ -221,10 +248,15 @@ namespace microunit {
   public:
     /**
     * @brief Run all the registered unit test cases.
+    * @param [in] report_path  Optional path of a JSON (.json) or CSV report
+    *             of per-test results.
     * @returns True if all tests pass, false otherwise.
     */
-    static bool Run() {
+    static bool Run(const std::string &report_path = "") {
       std::vector<std::string> failures, sucesses;
+      std::vector<UnitReport> reports;
+      const AllocationCounter count_allocations =
+        Instance().allocation_counter_;
 
       TERMINAL_INFO
         << "Will run " << Instance().unitfunction_map_.size()
@@ -235,19 +267,46 @@ namespace microunit {
         std::cout << MICROUNIT_SEPARATOR << std::endl;
         TERMINAL_GOOD << "Test case '" << unit.first << "'";
 
-        // Run the unit test
+        // Run and time the unit test
         UnitFunctionResult result;
+        size_t allocations_before =
+          count_allocations ? count_allocations() : 0;
+        auto start = std::chrono::steady_clock::now();
         unit.second(&result);
+        double time_ms = std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - start).count();
+
+        UnitReport report;
+        report.name = unit.first;
+        report.time_ms = time_ms;
+        report.time_budget_ms = result.time_budget_ms;
+        if (count_allocations) {
+          report.allocations =
+            static_cast<long>(count_allocations() - allocations_before);
+        }
+
+        if (result.success && result.time_budget_ms > 0 &&
+          time_ms > result.time_budget_ms) {
+          TERMINAL_BAD << "Time budget exceeded: " << time_ms << " ms > "
+            << result.time_budget_ms << " ms";
+          result.success = false;
+        }
+        report.success = result.success;
+        reports.push_back(report);
 
         if (!result.success) {
-          TERMINAL_BAD << "Failed test";
+          TERMINAL_BAD << "Failed test (" << time_ms << " ms)";
           failures.push_back(unit.first);
         }
         else {
-          TERMINAL_GOOD << "Passed test";
+          TERMINAL_GOOD << "Passed test (" << time_ms << " ms)";
           sucesses.push_back(unit.first);
         }
       }
+
+      if (!report_path.empty() && !WriteReport(report_path, reports)) {
+        TERMINAL_BAD << "Could not write report to " << report_path;
+      }
       std::cout
         << MICROUNIT_SEPARATOR << std::endl
         << MICROUNIT_SEPARATOR << std::endl;
@@ -276,6 +335,56 @@ namespace microunit {
       }
     }
 
+    /**
+    * @brief Write per-test results to a file, as JSON if the path ends in
+    *        .json and as CSV otherwise.
+    * @param [in] path  Path of the report file.
+    * @param [in] reports  Results of the test cases.
+    * @returns True if the report was written, false otherwise.
+    */
+    static bool WriteReport(const std::string &path,
+      const std::vector<UnitReport> &reports) {
+      std::ofstream os(path);
+      if (!os) {
+        return false;
+      }
+      const bool json = path.size() >= 5 &&
+        path.compare(path.size() - 5, 5, ".json") == 0;
+
+      if (json) {
+        os << "{\n  \"tests\": [";
+        for (size_t n = 0; n < reports.size(); n++) {
+          const UnitReport &r = reports[n];
+          os << (n ? ",\n" : "\n") << "    {\"name\": \"" << r.name
+            << "\", \"passed\": " << (r.success ? "true" : "false")
+            << ", \"time_ms\": " << r.time_ms
+            << ", \"time_budget_ms\": " << r.time_budget_ms;
+          if (r.allocations >= 0) {
+            os << ", \"allocations\": " << r.allocations;
+          }
+          os << "}";
+        }
+        os << "\n  ]\n}\n";
+      }
+      else {
+        os << "name,passed,time_ms,time_budget_ms,allocations\n";
+        for (const UnitReport &r : reports) {
+          os << r.name << "," << (r.success ? 1 : 0) << "," << r.time_ms
+            << "," << r.time_budget_ms << "," << r.allocations << "\n";
+        }
+      }
+      return static_cast<bool>(os);
+    }
+
+    /**
+    * @brief Set the function used to count heap allocations made by each
+    *        unit test case. Without one, allocations are not reported.
+    * @param [in] counter  Function returning the allocation count so far.
+    */
+    static void SetAllocationCounter(AllocationCounter counter) {
+      Instance().allocation_counter_ = counter;
+    }
+
     /**
     * @brief Register a unit test case function. In regular library client usage,
     *        this doesn't need to be called, and the macro UNIT should be used
@@ -318,6 +427,7 @@ namespace microunit {
       return instance;
     }
     std::map<std::string, UnitFunction> unitfunction_map_;
+    AllocationCounter allocation_counter_{ nullptr };
   };
 }
 
@@ -380,4 +490,13 @@ FAIL();                                                                        \
 LOG_BAD << "Assert-false failed: " #condition << std::endl;                    \
 FAIL();                                                                        \
 }
+
+/**
+* @brief Set a wall time budget for the test case, in milliseconds. The test
+*        fails if it takes longer, which catches slowdowns in tests that
+*        double as speed canaries.
+*/
+#define TIME_BUDGET_MS(ms) {                                                   \
+__microunit_testresult->time_budget_ms = (ms);                                 \
+}
 #endif
\ No newline at end of file
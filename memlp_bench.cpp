@@ -0,0 +1,25 @@
+#include <iostream>
+
+#include "microbench.h"
+#include "easylogging++.h"
+
+
+// Include benchmarks as CPP!
+#include "bench/MLPBench.cpp"
+#include "bench/DatasetBench.cpp"
+#include "bench/ActivationBench.cpp"
+#include "bench/SerialiseBench.cpp"
+#include "bench/RandomBench.cpp"
+#include "bench/LossBench.cpp"
+
+
+int main(int argc, char* argv[])
+{
+    // Initialise the logger
+    START_EASYLOGGINGPP(argc, argv);
+
+    // Run benchmarks and write the report
+    bool report_written = microbench::BenchRunner::Run(argc, argv);
+
+    return report_written ? 0 : 1;
+}
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <string>
 
 #ifndef LINUX
 #include "pico/stdlib.h"
@@ -19,13 +20,23 @@
 
 #ifdef LINUX
 
-int main(int, char**)
+int main(int argc, char** argv)
 {
     // Initialise the logger
     START_EASYLOGGINGPP(argc, argv);
 
+    // Optional per-test report: --report=results.json or --report=results.csv
+    std::string report_path;
+    for (int n = 1; n < argc; n++) {
+        const std::string arg(argv[n]);
+        if (arg.rfind("--report=", 0) == 0) {
+            report_path = arg.substr(9);
+        }
+    }
+    microunit::UnitTester::SetAllocationCounter(&alloc_counter::Count);
+
     // Run unit tests
-    bool tests_passed = microunit::UnitTester::Run();
+    bool tests_passed = microunit::UnitTester::Run(report_path);
 
     return tests_passed ? 0 : 1;  // Return 0 if all tests passed, otherwise 1
 }
@@ -414,3 +414,40 @@ UNIT(DatasetSetMaxExamples) {
         ASSERT_EQ(sampledLabels[i][0], static_cast<float>(i * 10));
     }
 }
+
+UNIT(DatasetFIFOOrder) {
+    // FIFO forgetting keeps the newest examples, oldest first, however many
+    // times the storage wraps around.
+    Dataset ds;
+    ds.ReplayMemory(true);
+    ds.SetForgetMode(Dataset::FIFO);
+    ds.SetMaxExamples(5);
+
+    for (int i = 0; i < 23; ++i) {
+        std::vector<float> feature = { static_cast<float>(i), static_cast<float>(-i) };
+        std::vector<float> label   = { static_cast<float>(i * 10) };
+        bool added = ds.Add(feature, label);
+        ASSERT_TRUE(added);
+    }
+
+    auto features = ds.GetFeatures(false);
+    auto labels = ds.GetLabels();
+    ASSERT_EQ(features.size(), size_t(5));
+    ASSERT_EQ(labels.size(), size_t(5));
+    for (size_t i = 0; i < features.size(); ++i) {
+        const float expected = static_cast<float>(18 + i);
+        ASSERT_EQ(features[i].size(), size_t(2));
+        ASSERT_EQ(features[i][0], expected);
+        ASSERT_EQ(features[i][1], -expected);
+        ASSERT_EQ(labels[i][0], expected * 10);
+    }
+
+    // The bias variant appends 1 to the same rows, in the same order
+    auto features_with_bias = ds.GetFeatures(true);
+    ASSERT_EQ(features_with_bias.size(), size_t(5));
+    for (size_t i = 0; i < features_with_bias.size(); ++i) {
+        ASSERT_EQ(features_with_bias[i].size(), size_t(3));
+        ASSERT_EQ(features_with_bias[i][0], features[i][0]);
+        ASSERT_EQ(features_with_bias[i][2], 1.f);
+    }
+}
@@ -1,5 +1,7 @@
 #include "FuncLearnTest.hpp"
+#include "QuantiseTest.hpp"
 #include "Utils.h"
+#include "easylogging++.h"
 #if defined(MLP_VERBOSE)
 #include <stdio.h>
 #endif
@@ -160,6 +162,29 @@ void FuncLearnRunner::TrainModel(const unsigned int n_epochs)
 }
 
 
+/**
+ * Mean squared error over the validation set. With weight_bits set, the
+ * weights are first rounded to that many bits (see QuantiseWeights) on a
+ * copy of the model, so the trained float model is left untouched.
+ */
+number_t FuncLearnRunner::ValidateModel(const unsigned int weight_bits)
+{
+    MLP<number_t> mlp(*mlp_);
+    if (weight_bits) {
+        mlp.SetWeights(QuantiseWeights<number_t>(mlp.GetWeights(), weight_bits));
+    }
+
+    number_t squared_error = 0;
+    for (unsigned int n = 0; n < validation_set_->first.size(); n++) {
+        std::vector<number_t> output;
+        mlp.GetOutput(validation_set_->first[n], &output);
+        number_t error = output[0] - validation_set_->second[n][0];
+        squared_error += error * error;
+    }
+    return squared_error / static_cast<number_t>(validation_set_->first.size());
+}
+
+
 FUNCLEARNTEST_C_FN
 void funclearntest_main()
 {
@@ -176,6 +201,11 @@ void funclearntest_main()
     runner.MakeModel();
     runner.TrainModel(n_epochs);
 
+    // Accuracy cost of fixed-point weights against the float model
+    LOG(INFO) << "Validation MSE: float " << runner.ValidateModel()
+        << ", int16 " << runner.ValidateModel(16)
+        << ", int8 " << runner.ValidateModel(8) << std::endl;
+
 #if defined(MLP_VERBOSE)
     printf("--- FuncLearnTest completed. ---\n");
 #endif
@@ -184,8 +214,11 @@ void funclearntest_main()
 
 #if defined(FUNCLEARN_MAIN)
 
-int main(int argc, char* argv[])
+INITIALIZE_EASYLOGGINGPP
+
+int main(int, char**)
 {
+    START_EASYLOGGINGPP(argc, argv);
     funclearntest_main();
     return 0;
 }
@@ -4,6 +4,7 @@
 //============================================================================
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -13,6 +14,7 @@
 
 #include "UnitTest.hpp"
 #include "MLP.h"
+#include "QuantiseTest.hpp"
 
 
 // Example illustrating practical use of this MLP lib.
@@ -21,83 +23,188 @@
 
 const int input_size = 4;
 const int number_classes = 3;
-#if defined(_WIN32)
-const char *iris_dataset = "../../data/iris.data";
-const std::string iris_mlp_weights = "../../data/iris.mlp";
-#else
-const char *iris_dataset = "../data/iris.data";
-const std::string iris_mlp_weights = "../data/iris.mlp";
+// The iris data-set is not part of this repository. CMake passes its path
+// (MEMLP_IRIS_DATA) in IRIS_DATASET; without it only the loader tests run.
+#if defined(IRIS_DATASET)
+const char *iris_dataset = IRIS_DATASET;
+const std::string iris_mlp_weights = IRIS_MLP_WEIGHTS;
 #endif
 const std::array<std::string, number_classes> class_names =
 { "Iris-setosa", "Iris-versicolor", "Iris-virginica" };
 
 
-bool load_data(int *samples,
-  std::vector<double>  *input,
-  std::vector<double> *iris_class) {
-  // Load the iris data-set. 
-  FILE *in = fopen(iris_dataset, "r");
+// Reads the iris data-set in a single pass, converting each line straight
+// into a TrainingSample with one-hot encoded classes. Blank lines are skipped,
+// lines longer than the 1022 characters of the line buffer are malformed.
+bool load_data(const char *path,
+  std::vector<TrainingSample<iris_num_t>> *samples) {
+  FILE *in = fopen(path, "r");
   if (!in) {
-    LOG(ERROR) << "Could not open file: " << iris_dataset << ".";
+    LOG(ERROR) << "Could not open file: " << path << ".";
     return false;
   }
 
-  // Loop through the data to get a count.
   char line[1024];
-  while (!feof(in) && fgets(line, 1024, in)) {
-    ++(*samples);
-  }
-  fseek(in, 0, SEEK_SET);
-
-  LOG(INFO) << "Loading " << (*samples)
-    << " data points from " << iris_dataset << ".";
-  // Allocate memory for input and output data.
-  input->resize((*samples) * input_size);
-  iris_class->resize((*samples) * number_classes);
-
-  // Read the file into our arrays. 
-  int i, j;
-  for (i = 0; i < (*samples); ++i) {
-    double *p = &((*input)[0]) + i * input_size;
-    double *c = &((*iris_class)[0]) + i * number_classes;
-    for (int k = 0; k < number_classes; k++) {
-      c[k] = 0.0;
+  int line_number = 0;
+  while (fgets(line, sizeof(line), in)) {
+    ++line_number;
+    // No line ending before the end of the buffer: the line was cut short,
+    // unless this is the last line of the file
+    if (!strchr(line, '\n')) {
+      const int next = fgetc(in);
+      if (next != EOF) {
+        LOG(ERROR) << "Line " << line_number << " is too long.";
+        fclose(in);
+        return false;
+      }
     }
-
-    fgets(line, 1024, in);
-
-    char *split = strtok(line, ",");
-    for (j = 0; j < 4; ++j) {
-      p[j] = atof(split);
-      split = strtok(NULL, ",");
+    // Strip the line ending, Unix or Windows
+    line[strcspn(line, "\r\n")] = '\0';
+    if (line[0] == '\0') {
+      continue;
     }
 
-    if (strlen(split) >= 1 && split[strlen(split) - 1] == '\n')
-      split[strlen(split) - 1] = '\0';
-    if (strlen(split) >= 2 && split[strlen(split) - 2] == '\r')
-      split[strlen(split) - 2] = '\0';
-
-    if (strcmp(split, class_names[0].c_str()) == 0) {
-      c[0] = 1.0;
-    }
-    else if (strcmp(split, class_names[1].c_str()) == 0) {
-      c[1] = 1.0;
-    }
-    else if (strcmp(split, class_names[2].c_str()) == 0) {
-      c[2] = 1.0;
+    std::vector<iris_num_t> features(input_size);
+    char *field = line;
+    for (int j = 0; j < input_size; ++j) {
+      char *end;
+      features[j] = static_cast<iris_num_t>(strtod(field, &end));
+      if (end == field || *end != ',') {
+        LOG(ERROR) << "Malformed line " << line_number << ".";
+        fclose(in);
+        return false;
+      }
+      field = end + 1;
     }
-    else {
-      LOG(ERROR) << "Unknown iris_class " << split
-        << ".";
+
+    std::vector<iris_num_t> one_hot(number_classes, 0.0);
+    const auto class_name = std::find(class_names.begin(), class_names.end(),
+      field);
+    if (class_name == class_names.end()) {
+      LOG(ERROR) << "Unknown iris_class " << field
+        << " on line " << line_number << ".";
+      fclose(in);
       return false;
     }
+    one_hot[class_name - class_names.begin()] = 1.0;
+
+    samples->emplace_back(std::move(features), std::move(one_hot));
   }
 
   fclose(in);
+  LOG(INFO) << "Loaded " << samples->size()
+    << " data points from " << path << ".";
   return true;
 }
 
 
+// Writes a data file for the load_data tests below
+bool write_data_file(const char *path, const char *contents) {
+  FILE *out = fopen(path, "wb");
+  if (!out) {
+    return false;
+  }
+  const bool written = fputs(contents, out) >= 0;
+  return (fclose(out) == 0) && written;
+}
+
+
+UNIT(LoadIrisDataLineEndings) {
+  // CRLF and LF endings, blank lines of both kinds, no final newline
+  const char *path = "iris_line_endings.data";
+  ASSERT_TRUE(write_data_file(path,
+    "5.1,3.5,1.4,0.2,Iris-setosa\r\n"
+    "\n"
+    "7.0,3.2,4.7,1.4,Iris-versicolor\n"
+    "\r\n"
+    "6.3,3.3,6.0,2.5,Iris-virginica"));
+
+  std::vector<TrainingSample<iris_num_t>> samples;
+  const bool loaded = load_data(path, &samples);
+  remove(path);
+
+  ASSERT_TRUE(loaded);
+  ASSERT_TRUE(samples.size() == 3);
+  const std::vector<iris_num_t> expected_input{ 7.0, 3.2, 4.7, 1.4 };
+  ASSERT_TRUE(samples[1].input_vector() == expected_input);
+  for (size_t n = 0; n < samples.size(); n++) {
+    for (size_t k = 0; k < number_classes; k++) {
+      ASSERT_TRUE(samples[n].output_vector()[k] == (n == k ? 1.0 : 0.0));
+    }
+  }
+}
+
+
+UNIT(LoadIrisDataMalformed) {
+  const char *path = "iris_malformed.data";
+  const std::array<const char *, 4> malformed_lines = {
+    "5.1,abc,1.4,0.2,Iris-setosa\n",   // not a number
+    "5.1,3.5,1.4,Iris-setosa\n",       // missing feature
+    "5.1,3.5,1.4,0.2\n",               // missing class
+    "5.1,3.5,1.4,0.2,Iris-unknown\n",  // unknown class
+  };
+
+  for (const char *malformed_line : malformed_lines) {
+    const std::string contents =
+      std::string("4.9,3.0,1.4,0.2,Iris-setosa\n") + malformed_line;
+    ASSERT_TRUE(write_data_file(path, contents.c_str()));
+
+    std::vector<TrainingSample<iris_num_t>> samples;
+    const bool loaded = load_data(path, &samples);
+    remove(path);
+
+    ASSERT_FALSE(loaded);
+  }
+
+  std::vector<TrainingSample<iris_num_t>> samples;
+  ASSERT_FALSE(load_data("iris_missing.data", &samples));
+}
+
+
+UNIT(LoadIrisDataLongLine) {
+  const char *path = "iris_long_line.data";
+  const std::string sample_line = "5.1,3.5,1.4,0.2,Iris-setosa";
+
+  // Longest line that fits the buffer, zero-padded
+  std::string contents =
+    std::string(1022 - sample_line.size(), '0') + sample_line + "\n";
+  ASSERT_TRUE(write_data_file(path, contents.c_str()));
+  std::vector<TrainingSample<iris_num_t>> samples;
+  bool loaded = load_data(path, &samples);
+  ASSERT_TRUE(loaded);
+  ASSERT_TRUE(samples.size() == 1);
+
+  // One that would be read as two valid samples if split at the buffer size
+  contents = std::string(1023 - sample_line.size(), '0') + sample_line +
+    sample_line + "\n";
+  ASSERT_TRUE(write_data_file(path, contents.c_str()));
+  samples.clear();
+  loaded = load_data(path, &samples);
+  remove(path);
+  ASSERT_FALSE(loaded);
+}
+
+
+int count_correct(MLP<iris_num_t> &mlp,
+  const std::vector<TrainingSample<iris_num_t>> &samples_with_bias) {
+  int correct = 0;
+  for (const auto &sample : samples_with_bias) {
+    std::vector<iris_num_t> guess;
+    mlp.GetOutput(sample.input_vector(), &guess);
+    size_t class_id;
+    mlp.GetOutputClass(guess, &class_id);
+
+    if (sample.output_vector()[class_id] == 1.0) {
+      ++correct;
+    }
+  }
+  return correct;
+}
+
+
+#if defined(IRIS_DATASET)
+
+// Writes and reads back IRIS_MLP_WEIGHTS
 UNIT(TestIrisDataset) {
 
 #if defined(__XS3A__)
@@ -108,30 +215,15 @@ UNIT(TestIrisDataset) {
 #else  // __XS3A__
 
   LOG(INFO) << "Train MLP with IRIS dataset using backpropagation." << std::endl;
-  int samples = 0;
-  std::vector<double> input;
-  std::vector<double> iris_class;
+  std::vector<TrainingSample<iris_num_t>> training_sample_set_with_bias;
 
   // Load the data from file.
-  if (!load_data(&samples, &input, &iris_class)) {
+  if (!load_data(iris_dataset, &training_sample_set_with_bias)) {
     LOG(ERROR) << "Error processing input file." << std::endl;
     FAIL();
   }
+  const int samples = training_sample_set_with_bias.size();
 
-  std::vector<TrainingSample<iris_num_t>> training_set;
-  for (int j = 0; j < samples; ++j) {
-    std::vector<iris_num_t> training_set_input;
-    std::vector<iris_num_t> training_set_output;
-    training_set_input.reserve(4);
-    for (int i = 0; i < 4; i++)
-      training_set_input.push_back(*(&(input[0]) + j * 4 + i));
-    training_set_output.reserve(3);
-    for (int i = 0; i < 3; i++)
-      training_set_output.push_back(*(&(iris_class[0]) + j * 3 + i));
-    training_set.emplace_back(std::move(training_set_input),
-      std::move(training_set_output));
-  }
-  std::vector<TrainingSample<iris_num_t>> training_sample_set_with_bias(std::move(training_set));
   //set up bias
   for (auto & training_sample_with_bias : training_sample_set_with_bias) {
     training_sample_with_bias.AddBiasValue(1);
@@ -155,28 +247,40 @@ UNIT(TestIrisDataset) {
   {
     MLP<iris_num_t> my_mlp(iris_mlp_weights);
 
-    int correct = 0;
-    for (int j = 0; j < samples; ++j) {
-      std::vector<iris_num_t> guess;
-      my_mlp.GetOutput(training_sample_set_with_bias[j].input_vector(), &guess);
-      size_t class_id;
-      my_mlp.GetOutputClass(guess, &class_id);
-
-      if (iris_class[j * 3 + 0] == 1.0 && class_id == 0) {
-        ++correct;
-      }
-      else if (iris_class[j * 3 + 1] == 1.0  && class_id == 1) {
-        ++correct;
-      }
-      else if (iris_class[j * 3 + 2] == 1.0 && class_id == 2) {
-        ++correct;
-      }
-    }
+    int correct = count_correct(my_mlp, training_sample_set_with_bias);
     LOG(INFO) << correct << "/" << samples
       << " (" << ((double)correct / samples * 100.0) << "%)." << std::endl;
 
     ASSERT_TRUE(((double)correct / samples) > 0.992);
+
+    // Accuracy cost of fixed-point weights against the float model
+    for (unsigned int bits : { 16u, 8u }) {
+      MLP<iris_num_t> q_mlp(iris_mlp_weights);
+      q_mlp.SetWeights(QuantiseWeights<iris_num_t>(q_mlp.GetWeights(), bits));
+
+      int q_correct = count_correct(q_mlp, training_sample_set_with_bias);
+      LOG(INFO) << "int" << bits << " weights: " << q_correct << "/" << samples
+        << " (" << ((double)(q_correct - correct) / samples * 100.0)
+        << "% vs float)." << std::endl;
+
+      if (bits == 16) {
+        ASSERT_TRUE(q_correct >= correct - 1);
+      }
+    }
   }
 
 #endif  // __XS3A__
 }
+
+#endif  // IRIS_DATASET
+
+
+#if defined(IRISDATASETTEST_MAIN)
+
+int main(int, char**) {
+  START_EASYLOGGINGPP(argc, argv);
+  bool tests_passed = microunit::UnitTester::Run();
+  return tests_passed ? 0 : 1;
+}
+
+#endif  // IRISDATASETTEST_MAIN
@@ -56,6 +56,52 @@ UNIT(TestGetOutputAfterActivationFunction) {
     }
 }
 
+/**
+ * Layer widths which are not a multiple of any vector width, so that
+ * SIMD kernels have to handle their tails, against a scalar reference.
+ * Linear activation: the activation itself is covered by the test above.
+ */
+UNIT(TestGetOutputAfterActivationFunctionOddWidth) {
+
+    const unsigned int in_size = 11;
+    const unsigned int out_size = 9;
+
+    auto test_layer = std::make_unique< Layer<num_t> >(
+        in_size, out_size, ACTIVATION_FUNCTIONS::LINEAR, false
+    );
+
+    std::vector< std::vector<num_t> > init_weights(out_size);
+    for (unsigned int n = 0; n < out_size; n++) {
+        for (unsigned int k = 0; k < in_size; k++) {
+            init_weights[n].push_back(0.125f * (num_t(k) - num_t(n)) / in_size);
+        }
+    }
+    test_layer->SetWeights(init_weights);
+
+    std::vector<num_t> input;
+    for (unsigned int k = 0; k < in_size - 1; k++) {
+        input.push_back(num_t(k % 3) - 1.f);
+    }
+    input.push_back(1.);  // bias
+
+    std::vector<num_t> expected_output;
+    for (unsigned int n = 0; n < out_size; n++) {
+        num_t acc = 0;
+        for (unsigned int k = 0; k < in_size; k++) {
+            acc += init_weights[n][k] * input[k];
+        }
+        expected_output.push_back(acc);
+    }
+
+    std::vector<num_t> actual_output;
+    test_layer->GetOutputAfterActivationFunction(input, &actual_output);
+
+    ASSERT_TRUE(actual_output.size() == expected_output.size());
+    for (unsigned int n = 0; n < actual_output.size(); n++) {
+        ASSERT_TRUE(utils::is_close<num_t>(expected_output[n], actual_output[n]));
+    }
+}
+
 #if defined(LAYERTEST_MAIN)
 
 int main(int argc, char* argv[]) {
@@ -5,6 +5,9 @@
 #include <vector>
 #include <algorithm>
 #include <cstdio>
+#if defined(LINUX)
+#include <thread>
+#endif
 
 #include "UnitTest.hpp"
 #include "MLP.h"
@@ -565,6 +568,66 @@ UNIT(MLPGetSetWeightsNew) {
 }
 
 
+UNIT(MLPWeightViewsConsistent) {
+    // GetWeights, GetLayerWeights and GetOutput must all see the same
+    // weights, however the layers store them internally.
+    std::vector<size_t> nodes{ 3, 5, 4, 2 };
+    MLP<num_t> mlp(
+        nodes,
+        { ACTIVATION_FUNCTIONS::LINEAR,
+          ACTIVATION_FUNCTIONS::LINEAR,
+          ACTIVATION_FUNCTIONS::LINEAR }
+    );
+
+    // Distinct value per weight: layer, node and input index
+    MLP<num_t>::mlp_weights new_weights(nodes.size() - 1);
+    for (unsigned int l = 0; l < new_weights.size(); l++) {
+        new_weights[l].resize(nodes[l + 1]);
+        for (unsigned int n = 0; n < nodes[l + 1]; n++) {
+            for (unsigned int k = 0; k < nodes[l]; k++) {
+                new_weights[l][n].push_back(
+                    0.1f * (l + 1) - 0.05f * n + 0.01f * k);
+            }
+        }
+    }
+    mlp.SetWeights(new_weights);
+
+    auto weights = mlp.GetWeights();
+    compare_weights_eq(weights, new_weights);
+    ASSERT_TRUE(mlp.GetNumLayers() == new_weights.size());
+    for (unsigned int l = 0; l < mlp.GetNumLayers(); l++) {
+        ASSERT_TRUE(mlp.GetLayerWeights(l) == new_weights[l]);
+    }
+
+    // Overwriting one layer leaves the others alone
+    std::vector<std::vector<num_t>> layer_weights(
+        nodes[2], std::vector<num_t>(nodes[1], -0.25f));
+    mlp.SetLayerWeights(1, layer_weights);
+    new_weights[1] = layer_weights;
+    weights = mlp.GetWeights();
+    compare_weights_eq(weights, new_weights);
+
+    // Forward pass matches a reference computed from the weights
+    const std::vector<num_t> input{ 0.5f, -1.f, 1.f };
+    std::vector<num_t> expected(input);
+    for (const auto &layer : new_weights) {
+        std::vector<num_t> next(layer.size(), 0);
+        for (unsigned int n = 0; n < layer.size(); n++) {
+            for (unsigned int k = 0; k < layer[n].size(); k++) {
+                next[n] += layer[n][k] * expected[k];
+            }
+        }
+        expected = next;
+    }
+    std::vector<num_t> output;
+    mlp.GetOutput(input, &output);
+    ASSERT_TRUE(output.size() == expected.size());
+    for (unsigned int n = 0; n < output.size(); n++) {
+        ASSERT_TRUE(utils::is_close<num_t>(output[n], expected[n]));
+    }
+}
+
+
 UNIT(MLPSerialise) {
 #if 1
         MLP<num_t> mlp(
@@ -597,7 +660,10 @@ UNIT(MLPSerialise) {
 }
 
 
-UNIT(MLPUpdateWeigthsMSE) {
+// One step from the PyTorch reference weights, by Train or by
+// MiniBatchTrain with a single sample and a mini-batch of 1, which is the
+// same SGD step. True if the updated weights match the reference.
+static bool UpdateWeightsMSEMatchesReference(bool mini_batch) {
         // Weights from PyTorch reference
         // See: https://colab.research.google.com/drive/1DgNlTbtpo8XD8YEmGqpKu2ma4BiHRW_B
         std::vector< std::vector< std::vector<num_t> > > weights {
@@ -647,28 +713,52 @@ UNIT(MLPUpdateWeigthsMSE) {
                 model.SetLayerWeights(n, weights[n]);
         }
         // Train once
-        model.Train(
-                std::make_pair(input, expected_output),
-                1.,        // learning_rate
-                1,         // max_iteration
-                0.,        // min_error_cost
-                false    // output_log
-        );
+        const auto training_pair = std::make_pair(input, expected_output);
+        if (mini_batch) {
+                model.MiniBatchTrain(
+                        training_pair,
+                        1.,        // learning_rate
+                        1,         // max_iteration
+                        1,         // minibatch size
+                        0.         // min_error_cost
+                );
+        }
+        else {
+                model.Train(
+                        training_pair,
+                        1.,        // learning_rate
+                        1,         // max_iteration
+                        0.,        // min_error_cost
+                        false    // output_log
+                );
+        }
 
         // Check weights
         for (unsigned int l=0; l<model.GetNumLayers(); l++) {
                 auto layer_weights = model.GetLayerWeights(l);
                 for (unsigned int n=0; n<layer_weights.size(); n++) {
                         for (unsigned int k=0; k<layer_weights[n].size(); k++) {
-
-                                ASSERT_TRUE(utils::is_close(
+                                if (!utils::is_close(
                                         layer_weights[n][k],
-                                        expected_weights[l][n][k]
-                                ));
-
+                                        expected_weights[l][n][k])) {
+                                        LOG(INFO) << "Weight " << l << "," << n << "," << k
+                                                << " differs from the reference." << std::endl;
+                                        return false;
+                                }
                         }    // for k
                 }    // for n
         }    // for l
+        return true;
+}
+
+
+UNIT(MLPUpdateWeigthsMSE) {
+        ASSERT_TRUE(UpdateWeightsMSEMatchesReference(false));
+}
+
+
+UNIT(MLPUpdateWeigthsMSEMiniBatch) {
+        ASSERT_TRUE(UpdateWeightsMSEMatchesReference(true));
 }
 
 
@@ -738,6 +828,11 @@ int main(int argc, char* argv[]) {
 
 UNIT(MLPLearnXORCategoricalCrossEntropy) {
     LOG(INFO) << "Train XOR function with MLP using categorical cross-entropy." << std::endl;
+#if defined(LINUX)
+    // Training-speed canary: a fixed 10000 iterations (min_cost 0) in the
+    // -O0 build. Measured 94-100 ms over 5 runs; 5x headroom
+    TIME_BUDGET_MS(500);
+#endif
 
     // XOR training data with one-hot encoded outputs for 2-class classification
     std::vector<TrainingSample<num_t>> training_set =
@@ -768,7 +863,7 @@ UNIT(MLPLearnXORCategoricalCrossEntropy) {
     );
 
     //Train MLP with higher learning rate and more lenient stopping criterion
-    my_mlp.Train(training_sample_set_with_bias, 3.0, 10000, 0.001);  // lr=3.0, max_iter=1000, min_cost=0.1
+    my_mlp.Train(training_sample_set_with_bias, 3.0, 10000, 0.0);  // lr=3.0, max_iter=10000, min_cost=0 so all iterations run
 
     // Test the trained network
     for (const auto & training_sample : training_sample_set_with_bias) {
@@ -810,6 +905,12 @@ UNIT(MLPLearnXORCategoricalCrossEntropy) {
 
 UNIT(MLPLearnXORCategoricalCrossEntropyMiniBatch) {
     LOG(INFO) << "Train XOR function with MLP using categorical cross-entropy and mini-batch." << std::endl;
+#if defined(LINUX)
+    // Training-speed canary: a fixed 500 mini-batch iterations (min_cost 0)
+    // in the -O0 build. Measured 5.4-5.7 ms over 5 runs; ~9x headroom, as
+    // scheduler noise weighs more on a run this short
+    TIME_BUDGET_MS(50);
+#endif
 
     // Convert to training_pair_t format for mini-batch training
     std::vector<std::vector<num_t>> features = {
@@ -843,7 +944,7 @@ UNIT(MLPLearnXORCategoricalCrossEntropyMiniBatch) {
                           5.0,   // learning rate increased from 0.8 to 5.0
                           500,   // max iterations increased from 200 to 500
                           2,     // mini-batch size
-                          0.15); // min error cost relaxed from 0.01 to 0.15
+                          0.0);  // min error cost 0, so all iterations run
 
     // Test the trained network
     for (size_t i = 0; i < features.size(); i++) {
@@ -868,3 +969,99 @@ UNIT(MLPLearnXORCategoricalCrossEntropyMiniBatch) {
 
     LOG(INFO) << "Mini-batch trained with success using categorical cross-entropy." << std::endl;
 }
+
+#if defined(LINUX)
+
+#if defined(MLP_ALLOCATION_TESTS)
+// Off by default (MEMLP_ALLOCATION_TESTS): the library still allocates
+// per layer in GetOutput until it preallocates its activation buffers.
+UNIT(MLPGetOutputNoAllocations) {
+    // Inference must be usable from a real-time audio callback: once the
+    // caller's output vector has its size, GetOutput may not touch the heap.
+    static const unsigned int kN_calls = 10;
+
+    MLP<num_t> mlp(
+        { 5, 16, 16, 3 },
+        { ACTIVATION_FUNCTIONS::RELU,
+          ACTIVATION_FUNCTIONS::TANH,
+          ACTIVATION_FUNCTIONS::LINEAR }
+    );
+    const std::vector<num_t> input{ 0.1f, -0.2f, 0.3f, -0.4f, 1.f };
+    std::vector<num_t> output;
+    mlp.GetOutput(input, &output);
+
+    size_t allocations_before = alloc_counter::Count();
+    for (unsigned int n = 0; n < kN_calls; n++) {
+        mlp.GetOutput(input, &output);
+    }
+    size_t allocations = alloc_counter::Count() - allocations_before;
+    LOG(INFO) << "GetOutput allocations in " << kN_calls << " calls: "
+        << allocations << std::endl;
+    ASSERT_TRUE(allocations == 0);
+
+    // Same for new weights and for a copy of the model
+    mlp.SetWeights(mlp.GetWeights());
+    auto mlp2 = mlp;
+    std::vector<num_t> output2;
+    mlp2.GetOutput(input, &output2);
+
+    allocations_before = alloc_counter::Count();
+    for (unsigned int n = 0; n < kN_calls; n++) {
+        mlp.GetOutput(input, &output);
+        mlp2.GetOutput(input, &output2);
+    }
+    allocations = alloc_counter::Count() - allocations_before;
+    LOG(INFO) << "GetOutput allocations in " << 2 * kN_calls
+        << " calls after SetWeights/copy: " << allocations << std::endl;
+    ASSERT_TRUE(allocations == 0);
+    ASSERT_TRUE(output == output2);
+}
+#endif  // MLP_ALLOCATION_TESTS
+
+UNIT(MLPGetOutputPerThreadCopies) {
+    // Concurrent inference today: one copy of the model per thread, each
+    // giving the same outputs as the original evaluated serially.
+    static const unsigned int kN_threads = 4;
+    static const unsigned int kN_inputs = 64;
+    static const unsigned int kN_passes = 20;
+
+    MLP<num_t> mlp(
+        { 5, 16, 16, 3 },
+        { ACTIVATION_FUNCTIONS::RELU,
+          ACTIVATION_FUNCTIONS::TANH,
+          ACTIVATION_FUNCTIONS::LINEAR }
+    );
+    std::vector< std::vector<num_t> > inputs, expected(kN_inputs);
+    for (unsigned int n = 0; n < kN_inputs; n++) {
+        const num_t x = static_cast<num_t>(n) / kN_inputs;
+        inputs.push_back({ x, -x, 0.5f * x, 1.f - x, 1.f });
+        mlp.GetOutput(inputs[n], &expected[n]);
+    }
+
+    std::vector< MLP<num_t> > copies(kN_threads, mlp);
+    // One flag per thread, not std::vector<bool> which packs them in bits
+    std::vector<int> matches(kN_threads, 1);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < kN_threads; t++) {
+        threads.emplace_back([&, t]() {
+            std::vector<num_t> output;
+            for (unsigned int pass = 0; pass < kN_passes; pass++) {
+                for (unsigned int n = 0; n < kN_inputs; n++) {
+                    copies[t].GetOutput(inputs[n], &output);
+                    if (output != expected[n]) {
+                        matches[t] = 0;
+                    }
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (unsigned int t = 0; t < kN_threads; t++) {
+        ASSERT_TRUE(matches[t]);
+    }
+}
+
+#endif  // LINUX
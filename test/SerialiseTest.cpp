@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 
 void dump_buffers(const unsigned char *expected,
         const unsigned char *actual, uint32_t size) {
@@ -159,6 +160,51 @@ UNIT(SerialiseToVector2d) {
     ASSERT_TRUE(expected == vec_out);
 }
 
+UNIT(SerialiseRoundTripOddSize) {
+
+    // Sizes that are not a multiple of any copy width, values whose bytes
+    // are all different, written after an existing prefix
+    const uint32_t rows = 3, cols = 7;
+    std::vector< std::vector<float> > vec_in(rows, std::vector<float>(cols));
+    for (uint32_t r = 0; r < rows; r++) {
+        for (uint32_t c = 0; c < cols; c++) {
+            vec_in[r][c] = -1.f / 3.f + 0.01f * r - 123.456f * c;
+        }
+    }
+    const std::vector<uint8_t> prefix = { 0xde, 0xad, 0xbe };
+    std::vector<uint8_t> buffer(prefix);
+
+    // Expected: little-endian uint32 sizes, then little-endian float32 rows
+    std::vector<uint8_t> expected(prefix);
+    auto append_le = [&expected](uint32_t word) {
+        for (unsigned int b = 0; b < 4; b++) {
+            expected.push_back(static_cast<uint8_t>(word >> (8 * b)));
+        }
+    };
+    append_le(rows);
+    append_le(cols);
+    for (const auto &row : vec_in) {
+        for (const float x : row) {
+            uint32_t word;
+            std::memcpy(&word, &x, sizeof(word));
+            append_le(word);
+        }
+    }
+
+    uint32_t w_head = prefix.size();
+    w_head = Serialise::FromVector2D(w_head, vec_in, buffer);
+
+    ASSERT_TRUE(w_head == buffer.size());
+    ASSERT_TRUE(expected == buffer);
+
+    std::vector< std::vector<float> > vec_out;
+    uint32_t r_head = prefix.size();
+    r_head = Serialise::ToVector2D<float>(r_head, buffer, vec_out);
+
+    ASSERT_TRUE(r_head == buffer.size());
+    ASSERT_TRUE(vec_in == vec_out);
+}
+
 #if 0
 int main(int argc, char* argv[]) {
     START_EASYLOGGINGPP(argc, argv);